@@ -12,6 +12,13 @@
        void usage(const char *name)
        int main(int argc, char **argv)
        unsigned short udp_checksum(unsigned short *buf, int bytes)
+       void read_dummy_data(char *payload, FILE *dummy_file, int packet_size)
+       template <int PACKET_SIZE> void copy_dummy_data(char *payload, const char *dummy_data, size_t dummy_size, size_t *dummy_offset, int packet_size)
+       void copy_dummy_data(char *payload, const char *dummy_data, size_t dummy_size, size_t *dummy_offset, int packet_size)
+       void build_packet(char *buffer, const char *covert_buffer, uint32_t source_addr, uint32_t dest_addr, int packet_size)
+       constexpr int alphabet_find(char c)
+       constexpr codec_tables make_codec_tables()
+       constexpr bool codec_tables_valid()
    $
    $Description: This program communicates a message over UDP using covert
                  channels. The covert channel used is the source and dest-
@@ -32,21 +39,131 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #define MODE_NONE 0
 #define MODE_SERVER 1
 #define MODE_CLIENT 2
 
+// Regular dummy files up to this size are loaded into memory by the client.
+// Larger files and anything that is not a regular file are streamed instead.
+#define MAX_DUMMY_PRELOAD (64 * 1024 * 1024)
+
 // NOTE: This alphabet can be randomized to provide obscurity. This is not encryption however.
 //       There must be at most 32 characters in this array. The compiler should throw a warning
 //       if this limit is passed. The client and server programs must have the same alphabet.
-const char alphabet[32] = "abcdefghijklmnopqrstuvwxyz ?$&.";
+constexpr char alphabet[32] = "abcdefghijklmnopqrstuvwxyz ?$&.";
+
+// Lookup table from a character to its 5 bit alphabet index. Characters that are not in the
+// alphabet map to the index of a space. This is generated from the alphabet at compile time.
+struct codec_tables
+{
+    unsigned char index[256];
+};
+
+// The pseudo header used to compute the UDP checksum.
+struct pseudo_header
+{
+    uint32_t saddr;
+    uint32_t daddr;
+    uint8_t placeholder;
+    uint8_t protocol;
+    uint16_t udp_len;
+};
 
 int client(const char *covert_filename, const char *dummy_filename, const char *addr, const char *client_addr, int seconds_between_sends, int packet_size);
 int server(const char *covert_filename, const char *dummy_filename, const char *addr);
 void encode(const char *buffer, char *out_buffer);
 void decode(const char *buffer, char *out_buffer);
+unsigned short udp_checksum(unsigned short *buf, int bytes);
+void read_dummy_data(char *payload, FILE *dummy_file, int packet_size);
+void copy_dummy_data(char *payload, const char *dummy_data, size_t dummy_size, size_t *dummy_offset, int packet_size);
+void build_packet(char *buffer, const char *covert_buffer, uint32_t source_addr, uint32_t dest_addr, int packet_size);
+
+/* ========================================================================
+   $FUNCTION
+   $Name: alphabet_find
+   $Prototype: constexpr int alphabet_find(char c)
+   $Params: 
+       c: The character to search for
+   $
+   $Description: This function returns the index of a character in the
+                 alphabet or -1 if it is not found. Like strchr, the
+                 terminating null is considered part of the alphabet. $
+   ======================================================================== */
+constexpr int alphabet_find(char c)
+{
+    for (int i = 0; i < 32; i++)
+    {
+        if (alphabet[i] == c)
+        {
+            return i;
+        }
+        if (alphabet[i] == '\0')
+        {
+            break;
+        }
+    }
+
+    return -1;
+}
+
+/* ========================================================================
+   $FUNCTION
+   $Name: make_codec_tables
+   $Prototype: constexpr codec_tables make_codec_tables()
+   $Params: 
+   $
+   $Description: This function builds the character to index table used
+                 by encode. It is evaluated at compile time. $
+   ======================================================================== */
+constexpr codec_tables make_codec_tables()
+{
+    codec_tables tables = {};
+
+    for (int c = 0; c < 256; c++)
+    {
+        int index = alphabet_find((char)c);
+
+        // If we cannot find the character we input a space.
+        if (index < 0)
+        {
+            index = alphabet_find(' ');
+        }
+
+        tables.index[c] = (unsigned char)index;
+    }
+
+    return tables;
+}
+
+constexpr codec_tables codec = make_codec_tables();
+
+/* ========================================================================
+   $FUNCTION
+   $Name: codec_tables_valid
+   $Prototype: constexpr bool codec_tables_valid()
+   $Params: 
+   $
+   $Description: This function checks that every character in the alphabet
+                 maps back to its own index and that the alphabet contains
+                 a space. A duplicated character in a randomized alphabet
+                 would otherwise stop the server from decoding the data. $
+   ======================================================================== */
+constexpr bool codec_tables_valid()
+{
+    for (int i = 0; i < 32 && alphabet[i] != '\0'; i++)
+    {
+        if (codec.index[(unsigned char)alphabet[i]] != i)
+        {
+            return false;
+        }
+    }
+
+    return codec.index[(unsigned char)' '] < 32;
+}
+static_assert(codec_tables_valid(), "The alphabet must contain a space and no duplicate characters.");
 
 /* ========================================================================
    $FUNCTION
@@ -267,6 +384,156 @@ unsigned short udp_checksum(unsigned short *buf, int bytes)
     return answer;
 }
 
+/* ========================================================================
+   $FUNCTION
+   $Name: read_dummy_data
+   $Prototype: void read_dummy_data(char *payload, FILE *dummy_file, int packet_size)
+   $Params: 
+       payload: The output buffer. It must hold packet_size bytes.
+       dummy_file: The dummy data stream.
+       packet_size: How much dummy data to read.
+   $
+   $Description: This function reads the next packet_size bytes of dummy
+                 data from a stream, starting over when it reaches the end.
+                 This is used for dummy files that are not loaded into
+                 memory, such as pipes and devices. $
+   ======================================================================== */
+void read_dummy_data(char *payload, FILE *dummy_file, int packet_size)
+{
+    int bytes_to_read;
+    int bytes_read;
+
+    bytes_to_read = packet_size;
+    while (bytes_to_read > 0)
+    {
+        bytes_read = fread(payload + (packet_size - bytes_to_read), 1, bytes_to_read, dummy_file);
+
+        // If we reach the end of the dummy data, start over.
+        if (bytes_read == 0)
+        {
+            rewind(dummy_file);
+        }
+        bytes_to_read -= bytes_read;
+    }
+}
+
+/* ========================================================================
+   $FUNCTION
+   $Name: copy_dummy_data
+   $Prototype: template <int PACKET_SIZE> void copy_dummy_data(char *payload, const char *dummy_data, size_t dummy_size, size_t *dummy_offset, int packet_size)
+   $Params: 
+       payload: The output buffer. It must hold packet_size bytes.
+       dummy_data: The dummy data loaded into memory.
+       dummy_size: How many bytes of dummy data there are.
+       dummy_offset: Where to continue reading the dummy data. This is updated.
+       packet_size: How much dummy data to copy. Only used when PACKET_SIZE is 0.
+       PACKET_SIZE: The payload size known at compile time, or 0 for the generic path.
+   $
+   $Description: This function copies the next packet_size bytes of dummy
+                 data from memory, starting over when it reaches the end.
+                 When the payload does not wrap around, a known size is a
+                 single fixed size copy that the compiler can inline. $
+   ======================================================================== */
+template <int PACKET_SIZE>
+void copy_dummy_data(char *payload, const char *dummy_data, size_t dummy_size, size_t *dummy_offset, int packet_size)
+{
+    const size_t size = (PACKET_SIZE > 0) ? PACKET_SIZE : packet_size;
+    size_t offset = *dummy_offset;
+    size_t bytes_copied = 0;
+
+    if (PACKET_SIZE > 0 && size < dummy_size - offset)
+    {
+        memcpy(payload, dummy_data + offset, PACKET_SIZE);
+        *dummy_offset = offset + PACKET_SIZE;
+        return;
+    }
+
+    while (bytes_copied < size)
+    {
+        size_t bytes_to_copy = dummy_size - offset;
+        if (bytes_to_copy > size - bytes_copied)
+        {
+            bytes_to_copy = size - bytes_copied;
+        }
+
+        memcpy(payload + bytes_copied, dummy_data + offset, bytes_to_copy);
+        bytes_copied += bytes_to_copy;
+        offset += bytes_to_copy;
+
+        // If we reach the end of the dummy data, start over.
+        if (offset == dummy_size)
+        {
+            offset = 0;
+        }
+    }
+    *dummy_offset = offset;
+}
+
+/* ========================================================================
+   $FUNCTION
+   $Name: copy_dummy_data
+   $Prototype: void copy_dummy_data(char *payload, const char *dummy_data, size_t dummy_size, size_t *dummy_offset, int packet_size)
+   $Params: 
+       payload: The output buffer. It must hold packet_size bytes.
+       dummy_data: The dummy data loaded into memory.
+       dummy_size: How many bytes of dummy data there are.
+       dummy_offset: Where to continue reading the dummy data. This is updated.
+       packet_size: How much dummy data to copy.
+   $
+   $Description: This function dispatches to a copy_dummy_data specialized
+                 for common packet sizes. Any other size uses the generic
+                 path. Run make bench to compare the two. $
+   ======================================================================== */
+void copy_dummy_data(char *payload, const char *dummy_data, size_t dummy_size, size_t *dummy_offset, int packet_size)
+{
+    switch (packet_size)
+    {
+        case 64:   copy_dummy_data<64>(payload, dummy_data, dummy_size, dummy_offset, packet_size); break;
+        case 100:  copy_dummy_data<100>(payload, dummy_data, dummy_size, dummy_offset, packet_size); break;
+        case 512:  copy_dummy_data<512>(payload, dummy_data, dummy_size, dummy_offset, packet_size); break;
+        case 1472: copy_dummy_data<1472>(payload, dummy_data, dummy_size, dummy_offset, packet_size); break;
+        default:   copy_dummy_data<0>(payload, dummy_data, dummy_size, dummy_offset, packet_size); break;
+    }
+}
+
+/* ========================================================================
+   $FUNCTION
+   $Name: build_packet
+   $Prototype: void build_packet(char *buffer, const char *covert_buffer, uint32_t source_addr, uint32_t dest_addr, int packet_size)
+   $Params: 
+       buffer: The datagram. The payload after the UDP header must already be filled in.
+       covert_buffer: The 6 covert characters to put into the ports.
+       source_addr: The client address used in the pseudo header.
+       dest_addr: The destination address used in the pseudo header.
+       packet_size: How much dummy data is in the payload.
+   $
+   $Description: This function fills in the UDP header. It encodes the
+                 covert data into the ports and computes the checksum. $
+   ======================================================================== */
+void build_packet(char *buffer, const char *covert_buffer, uint32_t source_addr, uint32_t dest_addr, int packet_size)
+{
+    struct udphdr *udp_header = (struct udphdr*)buffer;
+    struct pseudo_header udp_pseudo_header;
+
+    // Put the UDP data in.
+    encode(covert_buffer, (char*)&udp_header->source);
+    encode(covert_buffer + 3, (char*)&udp_header->dest);
+
+    udp_header->source = htons(udp_header->source);
+    udp_header->dest = htons(udp_header->dest);
+    udp_header->len = htons(sizeof(struct udphdr) + packet_size);
+    udp_header->check = 0;
+
+    // Create the pseudo header
+    udp_pseudo_header.saddr = source_addr;
+    udp_pseudo_header.daddr = dest_addr;
+    udp_pseudo_header.placeholder = 0;
+    udp_pseudo_header.protocol = IPPROTO_UDP;
+    udp_pseudo_header.udp_len = htons(sizeof(struct udphdr) + packet_size);
+
+    udp_header->check = udp_checksum((unsigned short *)&udp_pseudo_header, sizeof(udp_pseudo_header));
+}
+
 /* ========================================================================
    $FUNCTION
    $Name: client
@@ -289,26 +556,22 @@ int client(const char *covert_filename, const char *dummy_filename, const char *
     FILE *covert_file = 0;
     FILE *dummy_file = 0;
     char covert_buffer[7] = {0};
+    struct stat dummy_stat;
+    char *dummy_data = 0;
+    size_t dummy_size = 0;
+    size_t dummy_offset = 0;
+    size_t dummy_read;
     int bytes_read;
     int bytes_to_read;
     int covert_running = 1;
 
     // Socket variables
     int sd;
-    struct udphdr *udp_header;
     struct sockaddr_in sin;
     uint32_t source_addr;
     uint32_t dest_addr;
     char *buffer;
     int zero = 0;
-    struct pseudo_header
-    {
-        uint32_t saddr;
-        uint32_t daddr;
-        uint8_t placeholder;
-        uint8_t protocol;
-        uint16_t udp_len;
-    } udp_pseudo_header;
 
 
     // Open the files.
@@ -323,6 +586,29 @@ int client(const char *covert_filename, const char *dummy_filename, const char *
         return -1;
     }
 
+    // Load regular dummy files into memory so that each payload is a single copy.
+    if (fstat(fileno(dummy_file), &dummy_stat) == 0 && S_ISREG(dummy_stat.st_mode) &&
+        dummy_stat.st_size > 0 && dummy_stat.st_size <= MAX_DUMMY_PRELOAD)
+    {
+        dummy_size = (size_t)dummy_stat.st_size;
+        dummy_data = (char*)malloc(dummy_size);
+
+        dummy_read = 0;
+        while (dummy_data != 0 && dummy_read < dummy_size)
+        {
+            size_t bytes = fread(dummy_data + dummy_read, 1, dummy_size - dummy_read, dummy_file);
+
+            // If the file could not be read in full, stream it instead.
+            if (bytes == 0)
+            {
+                free(dummy_data);
+                dummy_data = 0;
+            }
+            dummy_read += bytes;
+        }
+        rewind(dummy_file);
+    }
+
     // Create the socket
     if ((sd = socket(AF_INET, SOCK_RAW, IPPROTO_UDP)) == -1)
     {
@@ -352,8 +638,8 @@ int client(const char *covert_filename, const char *dummy_filename, const char *
     sin.sin_addr.s_addr = inet_addr(addr);
 
     // Allocate enough size for the buffer.
-    buffer = (char*)malloc(sizeof(udp_header) + packet_size);
-    memset(buffer, 0, sizeof(udp_header) + packet_size);
+    buffer = (char*)malloc(sizeof(struct udphdr) + packet_size);
+    memset(buffer, 0, sizeof(struct udphdr) + packet_size);
 
     printf("Sending data...\n");
     // Keep looping until the covert data has been sent.
@@ -383,41 +669,19 @@ int client(const char *covert_filename, const char *dummy_filename, const char *
             bytes_to_read--;
         }
 
-        // Read dummy data.
-        bytes_to_read = packet_size;
-        while (bytes_to_read > 0)
+        // Put the dummy data in.
+        if (dummy_data != 0)
         {
-            bytes_read = fread(buffer + sizeof(udp_header) + (packet_size - bytes_to_read), 1, bytes_to_read, dummy_file);
-
-            // If we reach the end of the dummy data, start over.
-            if (bytes_read == 0)
-            {
-                rewind(dummy_file);
-            }
-            bytes_to_read -= bytes_read;
+            copy_dummy_data(buffer + sizeof(struct udphdr), dummy_data, dummy_size, &dummy_offset, packet_size);
+        }
+        else
+        {
+            read_dummy_data(buffer + sizeof(struct udphdr), dummy_file, packet_size);
         }
 
+        build_packet(buffer, covert_buffer, source_addr, dest_addr, packet_size);
 
-        // Put the UDP data in.
-        udp_header = (struct udphdr*)buffer;
-        encode(covert_buffer, (char*)&udp_header->source);
-        encode(covert_buffer + 3, (char*)&udp_header->dest);
-
-        udp_header->source = htons(udp_header->source);
-        udp_header->dest = htons(udp_header->dest);
-        udp_header->len = htons(sizeof(udp_header) + packet_size);
-        udp_header->check = 0;
-
-        // Create the pseudo header
-        udp_pseudo_header.saddr = source_addr;
-        udp_pseudo_header.daddr = dest_addr;
-        udp_pseudo_header.placeholder = 0;
-        udp_pseudo_header.protocol = IPPROTO_UDP;
-        udp_pseudo_header.udp_len = htons(sizeof(udp_header) + packet_size);
-
-        udp_header->check = udp_checksum((unsigned short *)&udp_pseudo_header, sizeof(udp_pseudo_header));
-
-        if (sendto(sd, buffer, sizeof(udp_header) + packet_size, 0, (struct sockaddr*)&sin, sizeof(sin)) < 0)
+        if (sendto(sd, buffer, sizeof(struct udphdr) + packet_size, 0, (struct sockaddr*)&sin, sizeof(sin)) < 0)
         {
             printf("Error sending datagram.\n");
             return -1;
@@ -428,6 +692,7 @@ int client(const char *covert_filename, const char *dummy_filename, const char *
     }
 
     free(buffer);
+    free(dummy_data);
 
     return -1;
 }
@@ -562,45 +827,15 @@ int server(const char *covert_filename, const char *dummy_filename, const char *
    ======================================================================== */
 void encode(const char *buffer, char *out_buffer)
 {
-#define GETINDEX(c) (int)(strchr(alphabet, c) - alphabet)
-
-    int byte = 0;
-    int bit = 1;
-
-    // Clear the out buffer.
-    memset(out_buffer, 0, 2);
-
-    // Set the initial bit padding
-    out_buffer[0] = 0x80;
-
-    // Store the alphabet indices in an array
-    for(int i = 0; i < 3; i++)
-    {
-        int tmp = GETINDEX(buffer[i]);
-
-        // If we cannot find the character we input a space.
-        if (tmp < 0)
-        {
-            tmp = GETINDEX(' ');
-        }
-
-        // Insert the 5 bit character.
-        for(int j = 0; j < 5; j++)
-        {
-
-            // Get the current bit and put it into the output buffer
-            int tmp2 = (tmp >> (4 - j)) & 0x1;
-            out_buffer[byte] |= tmp2 << (7 - bit);
-
-            // Make sure we wrap to the next byte.
-            bit++;
-            if (bit > 7)
-            {
-                byte++;
-                bit = 0;
-            }
-        }
-    }
+    // The most significant bit is padding and is always set. The three 5 bit
+    // characters fill in the remaining 15 bits.
+    int value = 0x8000
+              | (codec.index[(unsigned char)buffer[0]] << 10)
+              | (codec.index[(unsigned char)buffer[1]] << 5)
+              | (codec.index[(unsigned char)buffer[2]]);
+
+    out_buffer[0] = (char)(value >> 8);
+    out_buffer[1] = (char)(value & 0xff);
 }
 
 /* ========================================================================
@@ -617,37 +852,10 @@ void encode(const char *buffer, char *out_buffer)
    ======================================================================== */
 void decode(const char *buffer, char *out_buffer)
 {
-    int byte = 0;
-    int bit = 1;
+    // Ignore the padding bit and split the remaining 15 bits into characters.
+    int value = (((unsigned char)buffer[0] << 8) | (unsigned char)buffer[1]) & 0x7fff;
 
-    // Clear the out buffer
-    memset(out_buffer, 0, 3);
-
-    int tmp_index;
-    for(int i = 0; i < 3; i++)
-    {
-        tmp_index = 0;
-        for(int j = 0; j < 5; j++)
-        {
-
-            // Get the current bit
-            char tmp_char = buffer[byte];
-            char tmp_bit = (tmp_char >> (7 - bit)) & 0x1;
-
-            // Set the bit in the index, and shift the index over.
-            tmp_index <<= 1;
-            tmp_index |= tmp_bit;
-
-            // Make sure we wrap to the next byte.
-            bit++;
-            if (bit > 7)
-            {
-                byte++;
-                bit = 0;
-            }
-        }
-
-        // Put the char in the output buffer.
-        out_buffer[i] = alphabet[tmp_index];
-    }
+    out_buffer[0] = alphabet[(value >> 10) & 0x1f];
+    out_buffer[1] = alphabet[(value >> 5) & 0x1f];
+    out_buffer[2] = alphabet[value & 0x1f];
 }
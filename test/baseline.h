@@ -0,0 +1,160 @@
+/* ========================================================================
+   $HEADER FILE
+   $File: baseline.h $
+   $Program: covert_channel $
+   $Developer: Jordan Marling $
+   $Created On: 2026/10/18 $
+   $Functions: 
+       void baseline_encode(const char *buffer, char *out_buffer)
+       void baseline_decode(const char *buffer, char *out_buffer)
+       unsigned short baseline_udp_checksum(unsigned short *buf, int bytes)
+       void baseline_build_packet(char *buffer, const char *covert_buffer, FILE *dummy_file, uint32_t source_addr, uint32_t dest_addr, int packet_size)
+   $
+   $Description: Reference copies of the original bit by bit codec, the
+                 checksum and the stdio based packet assembly from the
+                 client loop. The tests compare main.c against these and
+                 the benchmarks time them. This must be included after
+                 main.c. $
+   $
+   $Revisions: $
+   ======================================================================== */
+
+#ifndef BASELINE_H
+#define BASELINE_H
+
+// NOTE: The original computed strchr(alphabet, c) - alphabet before checking for a miss,
+//       which subtracts from a null pointer. The miss is checked first here so the reference
+//       behaves the same at every optimization level.
+static int baseline_getindex(char c)
+{
+    const char *found = strchr(alphabet, c);
+    return found ? (int)(found - alphabet) : -1;
+}
+
+void baseline_encode(const char *buffer, char *out_buffer)
+{
+    int byte = 0;
+    int bit = 1;
+
+    memset(out_buffer, 0, 2);
+    out_buffer[0] = 0x80;
+
+    for(int i = 0; i < 3; i++)
+    {
+        int tmp = baseline_getindex(buffer[i]);
+        if (tmp < 0)
+        {
+            tmp = baseline_getindex(' ');
+        }
+
+        for(int j = 0; j < 5; j++)
+        {
+            int tmp2 = (tmp >> (4 - j)) & 0x1;
+            out_buffer[byte] |= tmp2 << (7 - bit);
+
+            bit++;
+            if (bit > 7)
+            {
+                byte++;
+                bit = 0;
+            }
+        }
+    }
+}
+
+void baseline_decode(const char *buffer, char *out_buffer)
+{
+    int byte = 0;
+    int bit = 1;
+
+    memset(out_buffer, 0, 3);
+
+    int tmp_index;
+    for(int i = 0; i < 3; i++)
+    {
+        tmp_index = 0;
+        for(int j = 0; j < 5; j++)
+        {
+            char tmp_char = buffer[byte];
+            char tmp_bit = (tmp_char >> (7 - bit)) & 0x1;
+
+            tmp_index <<= 1;
+            tmp_index |= tmp_bit;
+
+            bit++;
+            if (bit > 7)
+            {
+                byte++;
+                bit = 0;
+            }
+        }
+
+        out_buffer[i] = alphabet[tmp_index];
+    }
+}
+
+unsigned short baseline_udp_checksum(unsigned short *buf, int bytes)
+{
+    long sum;
+    unsigned short oddbyte;
+    short answer;
+
+    sum = 0;
+    while (bytes > 1)
+    {
+        sum += *buf++;
+        bytes -= 2;
+    }
+
+    if (bytes == 1)
+    {
+        oddbyte = 0;
+        *((u_char*)&oddbyte) = *(u_char*)buf;
+        sum += oddbyte;
+    }
+
+    sum = (sum >> 16) + (sum & 0xffff);
+    sum = sum + (sum >> 16);
+    answer = (short)~sum;
+
+    return answer;
+}
+
+// The body of the original client loop after the covert data has been read.
+void baseline_build_packet(char *buffer, const char *covert_buffer, FILE *dummy_file, uint32_t source_addr, uint32_t dest_addr, int packet_size)
+{
+    struct udphdr *udp_header;
+    struct pseudo_header udp_pseudo_header;
+    int bytes_to_read;
+    int bytes_read;
+
+    bytes_to_read = packet_size;
+    while (bytes_to_read > 0)
+    {
+        bytes_read = fread(buffer + sizeof(struct udphdr) + (packet_size - bytes_to_read), 1, bytes_to_read, dummy_file);
+        if (bytes_read == 0)
+        {
+            rewind(dummy_file);
+        }
+        bytes_to_read -= bytes_read;
+    }
+
+    udp_header = (struct udphdr*)buffer;
+    baseline_encode(covert_buffer, (char*)&udp_header->source);
+    baseline_encode(covert_buffer + 3, (char*)&udp_header->dest);
+
+    udp_header->source = htons(udp_header->source);
+    udp_header->dest = htons(udp_header->dest);
+    udp_header->len = htons(sizeof(struct udphdr) + packet_size);
+    udp_header->check = 0;
+
+    udp_pseudo_header.saddr = source_addr;
+    udp_pseudo_header.daddr = dest_addr;
+    udp_pseudo_header.placeholder = 0;
+    udp_pseudo_header.protocol = IPPROTO_UDP;
+    udp_pseudo_header.udp_len = htons(sizeof(struct udphdr) + packet_size);
+
+    udp_header->check = baseline_udp_checksum((unsigned short *)&udp_pseudo_header, sizeof(udp_pseudo_header));
+}
+
+#endif
@@ -0,0 +1,250 @@
+/* ========================================================================
+   $SOURCE FILE
+   $File: codec_bench.cpp $
+   $Program: codec_bench $
+   $Developer: Jordan Marling $
+   $Created On: 2026/10/18 $
+   $Functions: 
+       double now()
+       void bench_codec()
+       void bench_build_packet(int packet_size)
+       template <int PACKET_SIZE> void bench_copy_dummy_data()
+       int main(int argc, char **argv)
+   $
+   $Description: This program times the codec and packet builders in
+                 main.c against the original implementations.
+                 To run it type
+                    make bench
+   $
+   $Revisions: $
+   ======================================================================== */
+
+#define main covert_channel_main
+#include "../main.c"
+#undef main
+
+#include <time.h>
+
+#include "baseline.h"
+
+#define CODEC_ITERATIONS 20000000
+#define PACKET_ITERATIONS 2000000
+#define DUMMY_SIZE 65536
+#define BENCH_RUNS 5
+
+// Written to after each timing loop so the compiler cannot remove the work.
+volatile char sink;
+
+/* ========================================================================
+   $FUNCTION
+   $Name: now
+   $Prototype: double now()
+   $Params: 
+   $
+   $Description: This function returns a monotonic time in nanoseconds. $
+   ======================================================================== */
+double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* ========================================================================
+   $FUNCTION
+   $Name: bench_codec
+   $Prototype: void bench_codec()
+   $Params: 
+   $
+   $Description: This function times encode and decode against the
+                 original bit by bit versions. $
+   ======================================================================== */
+void bench_codec()
+{
+    char text[3] = { 'a', 'z', '.' };
+    char port[2];
+    char out[3];
+    double start;
+
+    start = now();
+    for (int i = 0; i < CODEC_ITERATIONS; i++)
+    {
+        text[0] = alphabet[i & 31];
+        baseline_encode(text, port);
+        sink ^= port[1];
+    }
+    printf("baseline encode:  %6.2f ns/call\n", (now() - start) / CODEC_ITERATIONS);
+
+    start = now();
+    for (int i = 0; i < CODEC_ITERATIONS; i++)
+    {
+        text[0] = alphabet[i & 31];
+        encode(text, port);
+        sink ^= port[1];
+    }
+    printf("encode:           %6.2f ns/call\n", (now() - start) / CODEC_ITERATIONS);
+
+    start = now();
+    for (int i = 0; i < CODEC_ITERATIONS; i++)
+    {
+        port[0] = (char)i;
+        port[1] = (char)(i >> 8);
+        baseline_decode(port, out);
+        sink ^= out[0];
+    }
+    printf("baseline decode:  %6.2f ns/call\n", (now() - start) / CODEC_ITERATIONS);
+
+    start = now();
+    for (int i = 0; i < CODEC_ITERATIONS; i++)
+    {
+        port[0] = (char)i;
+        port[1] = (char)(i >> 8);
+        decode(port, out);
+        sink ^= out[0];
+    }
+    printf("decode:           %6.2f ns/call\n", (now() - start) / CODEC_ITERATIONS);
+}
+
+/* ========================================================================
+   $FUNCTION
+   $Name: bench_build_packet
+   $Prototype: void bench_build_packet(int packet_size)
+   $Params: 
+       packet_size: The payload size to build.
+   $
+   $Description: This function times building packets of one size with
+                 the original stdio client loop, with the dummy data
+                 streamed by read_dummy_data and with it copied from
+                 memory by copy_dummy_data. $
+   ======================================================================== */
+void bench_build_packet(int packet_size)
+{
+    char *buffer = (char*)calloc(sizeof(struct udphdr) + packet_size, 1);
+    char *dummy_data = (char*)malloc(DUMMY_SIZE);
+    FILE *dummy_file = tmpfile();
+    size_t dummy_offset = 0;
+    double start;
+
+    for (int i = 0; i < DUMMY_SIZE; i++)
+    {
+        dummy_data[i] = alphabet[i % 31];
+    }
+    fwrite(dummy_data, 1, DUMMY_SIZE, dummy_file);
+    rewind(dummy_file);
+
+    start = now();
+    for (int i = 0; i < PACKET_ITERATIONS; i++)
+    {
+        baseline_build_packet(buffer, "hello!", dummy_file, i, ~i, packet_size);
+        sink ^= buffer[sizeof(struct udphdr)];
+    }
+    printf("%4d bytes: baseline     %7.2f ns/packet\n", packet_size, (now() - start) / PACKET_ITERATIONS);
+
+    start = now();
+    for (int i = 0; i < PACKET_ITERATIONS; i++)
+    {
+        read_dummy_data(buffer + sizeof(struct udphdr), dummy_file, packet_size);
+        build_packet(buffer, "hello!", i, ~i, packet_size);
+        sink ^= buffer[sizeof(struct udphdr)];
+    }
+    printf("%4d bytes: streamed     %7.2f ns/packet\n", packet_size, (now() - start) / PACKET_ITERATIONS);
+
+    start = now();
+    for (int i = 0; i < PACKET_ITERATIONS; i++)
+    {
+        copy_dummy_data(buffer + sizeof(struct udphdr), dummy_data, DUMMY_SIZE, &dummy_offset, packet_size);
+        build_packet(buffer, "hello!", i, ~i, packet_size);
+        sink ^= buffer[sizeof(struct udphdr)];
+    }
+    printf("%4d bytes: in memory    %7.2f ns/packet\n", packet_size, (now() - start) / PACKET_ITERATIONS);
+
+    fclose(dummy_file);
+    free(dummy_data);
+    free(buffer);
+}
+
+/* ========================================================================
+   $FUNCTION
+   $Name: bench_copy_dummy_data
+   $Prototype: template <int PACKET_SIZE> void bench_copy_dummy_data()
+   $Params: 
+       PACKET_SIZE: The payload size to copy.
+   $
+   $Description: This function times only the dummy data copy, with the
+                 generic copy_dummy_data<0> and the fixed size
+                 copy_dummy_data<PACKET_SIZE> that the dispatcher in
+                 main.c uses for the common sizes. $
+   ======================================================================== */
+template <int PACKET_SIZE>
+void bench_copy_dummy_data()
+{
+    const int packet_size = PACKET_SIZE;
+    char *payload = (char*)malloc(packet_size);
+    char *dummy_data = (char*)malloc(DUMMY_SIZE);
+    double generic_best = 1e30;
+    double fixed_best = 1e30;
+    size_t dummy_offset;
+    double start;
+    double elapsed;
+
+    for (int i = 0; i < DUMMY_SIZE; i++)
+    {
+        dummy_data[i] = alphabet[i % 31];
+    }
+
+    // Alternate the two versions and keep the best run of each so that
+    // frequency scaling and other load affect both the same way.
+    for (int run = 0; run < BENCH_RUNS; run++)
+    {
+        dummy_offset = 0;
+        start = now();
+        for (int i = 0; i < PACKET_ITERATIONS; i++)
+        {
+            copy_dummy_data<0>(payload, dummy_data, DUMMY_SIZE, &dummy_offset, packet_size);
+            sink ^= payload[packet_size - 1];
+        }
+        elapsed = (now() - start) / PACKET_ITERATIONS;
+        generic_best = (elapsed < generic_best) ? elapsed : generic_best;
+
+        dummy_offset = 0;
+        start = now();
+        for (int i = 0; i < PACKET_ITERATIONS; i++)
+        {
+            copy_dummy_data<PACKET_SIZE>(payload, dummy_data, DUMMY_SIZE, &dummy_offset, packet_size);
+            sink ^= payload[packet_size - 1];
+        }
+        elapsed = (now() - start) / PACKET_ITERATIONS;
+        fixed_best = (elapsed < fixed_best) ? elapsed : fixed_best;
+    }
+
+    printf("%4d bytes: generic copy %7.2f ns/packet\n", packet_size, generic_best);
+    printf("%4d bytes: fixed copy   %7.2f ns/packet\n", packet_size, fixed_best);
+
+    free(dummy_data);
+    free(payload);
+}
+
+/* ========================================================================
+   $FUNCTION
+   $Name: main
+   $Prototype: int main(int argc, char **argv)
+   $Params: 
+   $
+   $Description: This is the main entry point into the benchmark program. $
+   ======================================================================== */
+int main(int argc, char **argv)
+{
+    const int packet_sizes[] = { 64, 100, 512, 1472 };
+
+    bench_codec();
+    for (int i = 0; i < 4; i++)
+    {
+        bench_build_packet(packet_sizes[i]);
+    }
+    bench_copy_dummy_data<64>();
+    bench_copy_dummy_data<100>();
+    bench_copy_dummy_data<512>();
+    bench_copy_dummy_data<1472>();
+
+    return 0;
+}
@@ -0,0 +1,324 @@
+/* ========================================================================
+   $SOURCE FILE
+   $File: codec_test.cpp $
+   $Program: codec_test $
+   $Developer: Jordan Marling $
+   $Created On: 2026/10/18 $
+   $Functions: 
+       unsigned int next_random()
+       int test_codec()
+       int test_checksum()
+       int test_build_packet(int packet_size, int dummy_size)
+       template <int PACKET_SIZE> int test_copy_dummy_data()
+       int main(int argc, char **argv)
+   $
+   $Description: This program compares the table driven codec and the
+                 in memory packet builder in main.c against the original
+                 implementations using random input. It returns
+                 non-zero if anything differs.
+                 To run it type
+                    make test
+   $
+   $Revisions: $
+   ======================================================================== */
+
+#define main covert_channel_main
+#include "../main.c"
+#undef main
+
+#include "baseline.h"
+
+#define CODEC_ITERATIONS 2000000
+#define PACKET_ITERATIONS 2000
+#define PACKETS_PER_ITERATION 16
+
+static unsigned int random_state = 0x12345678;
+
+/* ========================================================================
+   $FUNCTION
+   $Name: next_random
+   $Prototype: unsigned int next_random()
+   $Params: 
+   $
+   $Description: This is a xorshift generator with a fixed seed so that
+                 failures can be reproduced. $
+   ======================================================================== */
+unsigned int next_random()
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+/* ========================================================================
+   $FUNCTION
+   $Name: test_codec
+   $Prototype: int test_codec()
+   $Params: 
+   $
+   $Description: This function encodes random characters, half of which
+                 are in the alphabet, and decodes random port values with
+                 both implementations. It returns the number of mismatches. $
+   ======================================================================== */
+int test_codec()
+{
+    int failures = 0;
+
+    for (int i = 0; i < CODEC_ITERATIONS; i++)
+    {
+        char text[3];
+        char port[2];
+        char expected[3];
+        char actual[3];
+
+        for (int j = 0; j < 3; j++)
+        {
+            text[j] = (next_random() & 1) ? alphabet[next_random() % 32] : (char)next_random();
+        }
+
+        baseline_encode(text, expected);
+        encode(text, actual);
+        if (memcmp(expected, actual, 2) != 0)
+        {
+            if (failures++ < 10)
+            {
+                printf("encode(%02x %02x %02x): expected %02x%02x, got %02x%02x\n",
+                       (unsigned char)text[0], (unsigned char)text[1], (unsigned char)text[2],
+                       (unsigned char)expected[0], (unsigned char)expected[1],
+                       (unsigned char)actual[0], (unsigned char)actual[1]);
+            }
+        }
+
+        port[0] = (char)next_random();
+        port[1] = (char)next_random();
+
+        baseline_decode(port, expected);
+        decode(port, actual);
+        if (memcmp(expected, actual, 3) != 0)
+        {
+            if (failures++ < 10)
+            {
+                printf("decode(%02x%02x): mismatch\n", (unsigned char)port[0], (unsigned char)port[1]);
+            }
+        }
+    }
+
+    return failures;
+}
+
+/* ========================================================================
+   $FUNCTION
+   $Name: test_checksum
+   $Prototype: int test_checksum()
+   $Params: 
+   $
+   $Description: This function checksums random buffers of random length
+                 with both implementations. It returns the number of
+                 mismatches. $
+   ======================================================================== */
+int test_checksum()
+{
+    int failures = 0;
+    unsigned short buffer[64];
+
+    for (int i = 0; i < CODEC_ITERATIONS / 16; i++)
+    {
+        int bytes = next_random() % sizeof(buffer);
+
+        for (int j = 0; j < 64; j++)
+        {
+            buffer[j] = (unsigned short)next_random();
+        }
+
+        if (baseline_udp_checksum(buffer, bytes) != udp_checksum(buffer, bytes))
+        {
+            if (failures++ < 10)
+            {
+                printf("udp_checksum(%d bytes): mismatch\n", bytes);
+            }
+        }
+    }
+
+    return failures;
+}
+
+/* ========================================================================
+   $FUNCTION
+   $Name: test_build_packet
+   $Prototype: int test_build_packet(int packet_size, int dummy_size)
+   $Params: 
+       packet_size: The payload size to build.
+       dummy_size: How many bytes of random dummy data to use.
+   $
+   $Description: This function builds a run of packets from the same
+                 random covert and dummy data with the original stdio
+                 client loop, with the dummy data streamed by
+                 read_dummy_data and with it copied from memory by
+                 copy_dummy_data. The dummy data is shorter than the
+                 payload some of the time so the wrap around path is
+                 covered. It returns the number of mismatched packets. $
+   ======================================================================== */
+int test_build_packet(int packet_size, int dummy_size)
+{
+    int failures = 0;
+    int total_size = sizeof(struct udphdr) + packet_size;
+    char *dummy_data = (char*)malloc(dummy_size);
+    char *expected = (char*)calloc(total_size, 1);
+    char *streamed = (char*)calloc(total_size, 1);
+    char *copied = (char*)calloc(total_size, 1);
+    size_t dummy_offset = 0;
+    FILE *dummy_file = tmpfile();
+    FILE *stream_file = tmpfile();
+
+    for (int i = 0; i < dummy_size; i++)
+    {
+        dummy_data[i] = (char)next_random();
+    }
+    fwrite(dummy_data, 1, dummy_size, dummy_file);
+    rewind(dummy_file);
+    fwrite(dummy_data, 1, dummy_size, stream_file);
+    rewind(stream_file);
+
+    for (int i = 0; i < PACKETS_PER_ITERATION; i++)
+    {
+        char covert_buffer[6];
+        uint32_t source_addr = next_random();
+        uint32_t dest_addr = next_random();
+
+        for (int j = 0; j < 6; j++)
+        {
+            covert_buffer[j] = alphabet[next_random() % 32];
+        }
+
+        baseline_build_packet(expected, covert_buffer, dummy_file, source_addr, dest_addr, packet_size);
+
+        read_dummy_data(streamed + sizeof(struct udphdr), stream_file, packet_size);
+        build_packet(streamed, covert_buffer, source_addr, dest_addr, packet_size);
+
+        copy_dummy_data(copied + sizeof(struct udphdr), dummy_data, dummy_size, &dummy_offset, packet_size);
+        build_packet(copied, covert_buffer, source_addr, dest_addr, packet_size);
+
+        if (memcmp(expected, streamed, total_size) != 0 || memcmp(expected, copied, total_size) != 0)
+        {
+            if (failures++ < 10)
+            {
+                printf("build_packet(%d bytes, %d bytes of dummy data): packet %d mismatch\n", packet_size, dummy_size, i);
+            }
+        }
+    }
+
+    fclose(dummy_file);
+    fclose(stream_file);
+    free(dummy_data);
+    free(expected);
+    free(streamed);
+    free(copied);
+
+    return failures;
+}
+
+/* ========================================================================
+   $FUNCTION
+   $Name: test_copy_dummy_data
+   $Prototype: template <int PACKET_SIZE> int test_copy_dummy_data()
+   $Params: 
+       PACKET_SIZE: The specialized payload size to test.
+   $
+   $Description: This function copies random dummy data of random length
+                 from random offsets with copy_dummy_data<PACKET_SIZE> and
+                 the generic copy_dummy_data<0>. The lengths cover both the
+                 fixed size copy and the wrap around path. It returns the
+                 number of mismatched copies. $
+   ======================================================================== */
+template <int PACKET_SIZE>
+int test_copy_dummy_data()
+{
+    int failures = 0;
+    char expected[PACKET_SIZE];
+    char actual[PACKET_SIZE];
+    char *dummy_data = (char*)malloc(4 * PACKET_SIZE);
+
+    for (int i = 0; i < PACKET_ITERATIONS * PACKETS_PER_ITERATION; i++)
+    {
+        size_t dummy_size = 1 + next_random() % (4 * PACKET_SIZE);
+        size_t start_offset = next_random() % dummy_size;
+        size_t expected_offset = start_offset;
+        size_t actual_offset = start_offset;
+
+        for (size_t j = 0; j < dummy_size; j++)
+        {
+            dummy_data[j] = (char)next_random();
+        }
+
+        copy_dummy_data<0>(expected, dummy_data, dummy_size, &expected_offset, PACKET_SIZE);
+        copy_dummy_data<PACKET_SIZE>(actual, dummy_data, dummy_size, &actual_offset, PACKET_SIZE);
+
+        if (memcmp(expected, actual, PACKET_SIZE) != 0 || expected_offset != actual_offset)
+        {
+            if (failures++ < 10)
+            {
+                printf("copy_dummy_data<%d>(%d bytes of dummy data from %d): mismatch\n", PACKET_SIZE, (int)dummy_size, (int)start_offset);
+            }
+        }
+    }
+
+    free(dummy_data);
+
+    return failures;
+}
+
+/* ========================================================================
+   $FUNCTION
+   $Name: main
+   $Prototype: int main(int argc, char **argv)
+   $Params: 
+   $
+   $Description: This is the main entry point into the test program. $
+   ======================================================================== */
+int main(int argc, char **argv)
+{
+    const int packet_sizes[] = { 64, 100, 512, 1472 };
+    int failures;
+    int total_failures = 0;
+
+    failures = test_codec();
+    printf("encode/decode: %d mismatches in %d inputs\n", failures, CODEC_ITERATIONS);
+    total_failures += failures;
+
+    failures = test_checksum();
+    printf("udp_checksum: %d mismatches in %d inputs\n", failures, CODEC_ITERATIONS / 16);
+    total_failures += failures;
+
+    // The common packet sizes, then random sizes.
+    for (int i = 0; i < 5; i++)
+    {
+        int packet_size = (i < 4) ? packet_sizes[i] : 0;
+
+        failures = 0;
+        for (int j = 0; j < PACKET_ITERATIONS; j++)
+        {
+            int size = packet_size ? packet_size : 1 + (int)(next_random() % 2000);
+            failures += test_build_packet(size, 1 + (int)(next_random() % 3000));
+        }
+
+        if (packet_size)
+        {
+            printf("build_packet(%d bytes): %d mismatches in %d packets\n", packet_size, failures, PACKET_ITERATIONS * PACKETS_PER_ITERATION);
+        }
+        else
+        {
+            printf("build_packet(random sizes): %d mismatches in %d packets\n", failures, PACKET_ITERATIONS * PACKETS_PER_ITERATION);
+        }
+        total_failures += failures;
+    }
+
+    failures = test_copy_dummy_data<64>();
+    failures += test_copy_dummy_data<100>();
+    failures += test_copy_dummy_data<512>();
+    failures += test_copy_dummy_data<1472>();
+    printf("copy_dummy_data<64/100/512/1472>: %d mismatches in %d copies\n", failures, 4 * PACKET_ITERATIONS * PACKETS_PER_ITERATION);
+    total_failures += failures;
+
+    return total_failures ? 1 : 0;
+}